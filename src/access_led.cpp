@@ -5,9 +5,10 @@
   ******************************************************************************
   */
 #include <Arduino.h>
+#include "access_led.h"
 void AccessLed_Init(void)
 {
-    pinMode(PC13, OUTPUT);
+    pinMode(pinNametoDigitalPin(ACCESS_LED_PIN), OUTPUT);
 }
 
 /**
@@ -15,7 +16,7 @@ void AccessLed_Init(void)
  */
 void AccessLed_On(void)
 {
-  digitalWrite(PC13, LOW);
+  digitalWrite(pinNametoDigitalPin(ACCESS_LED_PIN), LOW);
 }
 
 /**
@@ -23,5 +24,5 @@ void AccessLed_On(void)
  */
 void AccessLed_Off(void)
 {
-  digitalWrite(PC13, HIGH);
+  digitalWrite(pinNametoDigitalPin(ACCESS_LED_PIN), HIGH);
 }
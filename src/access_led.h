@@ -8,6 +8,8 @@
 #ifndef ACCESS_LED_H_
 #define ACCESS_LED_H_
 
+#define ACCESS_LED_PIN PC_13 /**< Active low LED on the Blue Pill board */
+
 void AccessLed_Init(void);
 void AccessLed_On(void);
 void AccessLed_Off(void);
@@ -12,12 +12,16 @@
 #include <Arduino.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 #include "cartridge.h"
 #include "cartridge_hal.h"
 
 //-----------------------------------------------------------------------------
 // Function Prototypes
 //-----------------------------------------------------------------------------
+static void SelectRom(uint16_t address);
+static uint8_t ReadRom(uint16_t address);
+static uint32_t CalculateHash(const uint8_t *buf, uint16_t len);
 
 
 //-----------------------------------------------------------------------------
@@ -29,6 +33,12 @@
 //-----------------------------------------------------------------------------
 static uint16_t readDelay = 0;  /**< Delay between reads. \n Unit: ms */
 static const uint16_t kResetVector = 0xFFFC;  /**< Address of 6502 reset vector. */
+static const uint16_t kChipEnableTime = 1;    /**< ROM access time from chip enable to valid data, rounded up. \n Unit: us */
+static const uint16_t kProbeAddress = 0x1FFC;  /**< Reset vector in ROM. Read by the console at boot, so safe to probe. */
+
+static uint8_t preload[CARTRIDGE_BANK_SIZE]; /**< Copy of the ROM bank read right after insertion */
+static bool preloadValid = false;            /**< preload matches the cartridge's current bank */
+static uint32_t preloadHash = 0;             /**< FNV-1a hash of preload */
 
 
 //-----------------------------------------------------------------------------
@@ -42,20 +52,15 @@ void Cartridge_Init(void)
 
 /**
  * @brief Read from cartridge.
+ *
+ * Accessing the cartridge may switch banks, so this invalidates the preload.
  * @param[in] address   Address in VCS memory address space
  * @return Byte read from the cartridge ROM.
  */
 uint8_t Cartridge_Read(uint16_t address)
 {
-  uint8_t val;
-
-  HAL_Cartridge_DisableRom();
-  HAL_Cartridge_SetAddressBus(address);
-  delayMicroseconds(20);
-  HAL_Cartridge_EnableRom();
-  val = HAL_Cartridge_GetDataBus();
-
-  return val;
+  preloadValid = false;
+  return ReadRom(address);
 }
 
 /**
@@ -65,6 +70,7 @@ uint8_t Cartridge_Read(uint16_t address)
  */
 uint8_t Cartridge_ReadEmulated(uint16_t address, uint8_t data)
 {
+  preloadValid = false;
   HAL_Cartridge_SetAddressBus(address);
   HAL_Cartridge_SetDataBus(data);
   return CARTRIDGE_OK;
@@ -78,9 +84,22 @@ uint8_t Cartridge_ReadBlock(uint16_t start, uint16_t len, uint8_t* buf)
 
   if (end < kResetVector)
   {
+    // Serve the first full-bank read from the preload. The preload walked the
+    // bank in the same order, bankswitch hotspots included, so the cartridge is
+    // already in the state this read would leave it in. Any other read must
+    // reach the cartridge.
+    if (preloadValid && start == CARTRIDGE_PRELOAD_ADDRESS && len == CARTRIDGE_BANK_SIZE)
+    {
+      memcpy(buf, preload, len);
+      preloadValid = false;
+      return CARTRIDGE_OK;
+    }
+
+    preloadValid = false;
+
     for (uint32_t address = start; address < end; address++)
     {
-      val = Cartridge_Read(address);
+      val = ReadRom(address);
       *p = val;
       p++;
       //TODO put in delay
@@ -119,10 +138,90 @@ uint8_t Cartridge_SetReadDelay(uint16_t us)
 /**
  * @brief Detect if a cartridge has been inserted.
  *
+ * Selects the ROM and samples the data bus once with pull-ups and once with
+ * pull-downs. A floating bus follows the pulls, a ROM drives the same value both times.
  * @return true when a cartridge is detected, false otherwise
  */
 bool Cartridge_Detect(void)
 {
-  //TODO implement
-  return true;
+  uint8_t pulledUp;
+  uint8_t pulledDown;
+
+  SelectRom(kProbeAddress);
+  pulledUp = HAL_Cartridge_ProbeDataBus(INPUT_PULLUP);
+  pulledDown = HAL_Cartridge_ProbeDataBus(INPUT_PULLDOWN);
+  HAL_Cartridge_DisableRom();
+  HAL_Cartridge_DataBusInput();
+
+  return pulledUp == pulledDown;
+}
+
+/**
+ * @brief Read the ROM bank at CARTRIDGE_PRELOAD_ADDRESS into RAM and hash it.
+ *
+ * The next block read of exactly this bank is served from RAM, unless the
+ * cartridge is accessed otherwise or removed first.
+ */
+void Cartridge_Preload(void)
+{
+  for (uint16_t i = 0; i < CARTRIDGE_BANK_SIZE; i++)
+  {
+    preload[i] = ReadRom(CARTRIDGE_PRELOAD_ADDRESS + i);
+  }
+
+  preloadHash = CalculateHash(preload, CARTRIDGE_BANK_SIZE);
+  preloadValid = true;
+}
+
+/**
+ * @brief Discard the preload, e.g. when the cartridge may have been swapped unnoticed.
+ */
+void Cartridge_InvalidatePreload(void)
+{
+  preloadValid = false;
+}
+
+/**
+ * @brief Get the hash of the preloaded bank.
+ * @param[out] hash   FNV-1a hash of the preloaded bank
+ * @return true when the preload is valid, false otherwise
+ */
+bool Cartridge_GetPreloadHash(uint32_t *hash)
+{
+  *hash = preloadHash;
+  return preloadValid;
+}
+
+//-----------------------------------------------------------------------------
+// Private functions
+//-----------------------------------------------------------------------------
+/**
+ * @brief Put address on the bus and enable the ROM, waiting for the data to become valid.
+ */
+static void SelectRom(uint16_t address)
+{
+  HAL_Cartridge_DisableRom();
+  HAL_Cartridge_SetAddressBus(address);
+  delayMicroseconds(20);
+  HAL_Cartridge_EnableRom();
+  delayMicroseconds(kChipEnableTime);
+}
+
+static uint8_t ReadRom(uint16_t address)
+{
+  SelectRom(address);
+  return HAL_Cartridge_GetDataBus();
+}
+
+static uint32_t CalculateHash(const uint8_t *buf, uint16_t len)
+{
+  uint32_t hash = 2166136261UL;
+
+  for (uint16_t i = 0; i < len; i++)
+  {
+    hash ^= buf[i];
+    hash *= 16777619UL;
+  }
+
+  return hash;
 }
@@ -12,6 +12,9 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#define CARTRIDGE_BANK_SIZE 0x1000 /**< Size of the ROM window in 6508 address space */
+#define CARTRIDGE_PRELOAD_ADDRESS 0x1000 /**< Start of the bank preloaded on insertion */
+
 typedef enum {
   CARTRIDGE_OK = 0,
   CARTRIDGE_RANGE,
@@ -25,5 +28,8 @@ uint8_t Cartridge_ReadBlock(uint16_t start, uint16_t len, uint8_t* buf);
 uint8_t Cartridge_ReadEmulatedBlock(uint16_t start, uint16_t len, uint8_t* buf);
 uint8_t Cartridge_SetReadDelay(uint16_t us);
 bool Cartridge_Detect(void);
+void Cartridge_Preload(void);
+void Cartridge_InvalidatePreload(void);
+bool Cartridge_GetPreloadHash(uint32_t *hash);
 
 #endif /* CARTRIDGE_H_ */
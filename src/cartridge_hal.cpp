@@ -30,25 +30,23 @@ static const uint16_t kWriteProtected = 0x1000; /**< Address of ROM (game cartri
 static bool driveDataBus = false; /**< Data direction shadow register */
 static uint8_t dataBus = 0; /**< Data bus shadow register */
 static uint16_t addressBus = 0; /**< Address bus shadow register */
+static const uint16_t kProbeSettleTime = 5; /**< Time for bus pulls to settle before sampling. \n Unit: us */
 
 
 //------------------------------------------------------------------------------
 // Public functions - Init
 //------------------------------------------------------------------------------
 void HAL_Cartridge_Init(void) {
-  pinMode(A0_PIN, OUTPUT);
-  pinMode(A1_PIN, OUTPUT);
-  pinMode(A2_PIN, OUTPUT);
-  pinMode(A3_PIN, OUTPUT);
-  pinMode(A4_PIN, OUTPUT);
-  pinMode(A5_PIN, OUTPUT);
-  pinMode(A6_PIN, OUTPUT);
-  pinMode(A7_PIN, OUTPUT);
-  pinMode(A8_PIN, OUTPUT);
-  pinMode(A9_PIN, OUTPUT);
-  pinMode(A10_PIN, OUTPUT);
-  pinMode(A11_PIN, OUTPUT);
-  pinMode(CS_PIN, OUTPUT);
+  // pinMode takes care of port clocks and releasing JTAG pins.
+  for (size_t i = 0; i < sizeof(kAddressPins) / sizeof(kAddressPins[0]); i++) {
+    pinMode(pinNametoDigitalPin(kAddressPins[i]), OUTPUT);
+  }
+  for (size_t i = 0; i < sizeof(kDataPins) / sizeof(kDataPins[0]); i++) {
+    pinMode(pinNametoDigitalPin(kDataPins[i]), INPUT_PULLUP);
+  }
+  for (size_t i = 0; i < sizeof(kChipSelectPins) / sizeof(kChipSelectPins[0]); i++) {
+    pinMode(pinNametoDigitalPin(kChipSelectPins[i]), OUTPUT);
+  }
 
   HAL_Cartridge_DataBusInput();
   HAL_Cartridge_DisableRom();
@@ -76,18 +74,7 @@ void HAL_Cartridge_SetAddressBus(uint16_t address)
     HAL_Cartridge_DataBusInput();
   }
 
-  digitalWrite(A0_PIN, (bool)(addressBus & (1 << 0)) );
-  digitalWrite(A1_PIN, (bool)(addressBus & (1 << 1)) );
-  digitalWrite(A2_PIN, (bool)(addressBus & (1 << 2)) );
-  digitalWrite(A3_PIN, (bool)(addressBus & (1 << 3)) );
-  digitalWrite(A4_PIN, (bool)(addressBus & (1 << 4)) );
-  digitalWrite(A5_PIN, (bool)(addressBus & (1 << 5)) );
-  digitalWrite(A6_PIN, (bool)(addressBus & (1 << 6)) );
-  digitalWrite(A7_PIN, (bool)(addressBus & (1 << 7)) );
-  digitalWrite(A8_PIN, (bool)(addressBus & (1 << 8)) );
-  digitalWrite(A9_PIN, (bool)(addressBus & (1 << 9)) );
-  digitalWrite(A10_PIN, (bool)(addressBus & (1 << 10)) );
-  digitalWrite(A11_PIN, (bool)(addressBus & (1 << 11)) );
+  AddressBus::Write(addressBus);
 }
 
 
@@ -95,14 +82,7 @@ void HAL_Cartridge_SetDataBus(uint8_t data)
 {
   dataBus = data;
 
-  digitalWrite(D0_PIN, (dataBus & (1 << 0)));
-  digitalWrite(D1_PIN, (dataBus & (1 << 1)));
-  digitalWrite(D2_PIN, (dataBus & (1 << 2)));
-  digitalWrite(D3_PIN, (dataBus & (1 << 3)));
-  digitalWrite(D4_PIN, (dataBus & (1 << 4)));
-  digitalWrite(D5_PIN, (dataBus & (1 << 5)));
-  digitalWrite(D6_PIN, (dataBus & (1 << 6)));
-  digitalWrite(D7_PIN, (dataBus & (1 << 7)));
+  DataBus::Write(dataBus);
 }
 
 
@@ -116,14 +96,7 @@ uint8_t HAL_Cartridge_GetDataBus(void)
   }
   else
   {
-    data =  (bool)digitalRead(D0_PIN) ? (1 << 0) : 0;
-    data |= (bool)digitalRead(D1_PIN) ? (1 << 1) : 0;
-    data |= (bool)digitalRead(D2_PIN) ? (1 << 2) : 0;
-    data |= (bool)digitalRead(D3_PIN) ? (1 << 3) : 0;
-    data |= (bool)digitalRead(D4_PIN) ? (1 << 4) : 0;
-    data |= (bool)digitalRead(D5_PIN) ? (1 << 5) : 0;
-    data |= (bool)digitalRead(D6_PIN) ? (1 << 6) : 0;
-    data |= (bool)digitalRead(D7_PIN) ? (1 << 7) : 0;
+    data = DataBus::Read();
   }
 
   return data;
@@ -149,12 +122,29 @@ void HAL_Cartridge_DataBusOutput(void)
   DataBusMode(OUTPUT);
 }
 
+/**
+ * @brief Sample the data bus with the given pull resistors enabled.
+ *
+ * A floating bus follows the pull resistors, a bus driven by the cartridge ROM does not.
+ * Leaves the data bus as input with the given pull resistors enabled.
+ * @param pull[in] INPUT_PULLUP or INPUT_PULLDOWN
+ * @return Byte read from the data bus.
+ */
+uint8_t HAL_Cartridge_ProbeDataBus(uint32_t pull)
+{
+  driveDataBus = false;
+  DataBusMode(pull);
+  delayMicroseconds(kProbeSettleTime);
+
+  return HAL_Cartridge_GetDataBus();
+}
+
 /**
  * @brief Enable cartridge ROM output if not driving the output pins.
  */
 void HAL_Cartridge_EnableRom(void) {
   if (!driveDataBus) {
-    digitalWrite(CS_PIN, HIGH);
+    ChipSelect::Write(1);
   } else {
     // Safeguard to prevent damage to cartridge.
     // TODO raise error for this condition
@@ -167,20 +157,43 @@ void HAL_Cartridge_EnableRom(void) {
  * @brief Disable cartridge ROM output.
  */
 void HAL_Cartridge_DisableRom(void) {
-  digitalWrite(CS_PIN, LOW);
+  ChipSelect::Write(0);
 }
 
 //------------------------------------------------------------------------------
 // Private functions
 //------------------------------------------------------------------------------
+/**
+ * @brief Set the data bus pin mode.
+ * @param mode[in] OUTPUT, INPUT, INPUT_PULLUP or INPUT_PULLDOWN
+ */
 static void DataBusMode(uint32_t mode)
 {
-  pinMode(D0_PIN, mode);
-  pinMode(D1_PIN, mode);
-  pinMode(D2_PIN, mode);
-  pinMode(D3_PIN, mode);
-  pinMode(D4_PIN, mode);
-  pinMode(D5_PIN, mode);
-  pinMode(D6_PIN, mode);
-  pinMode(D7_PIN, mode);
+  switch (mode)
+  {
+  case OUTPUT:
+    // Load the output data first so the bus never drives a stale value.
+    DataBus::Write(dataBus);
+    DataBus::Configure(PINMAP_CONFIG_OUTPUT);
+    break;
+
+  case INPUT:
+    DataBus::Configure(PINMAP_CONFIG_INPUT);
+    break;
+
+  // Stop driving before the output data bits are reused to select the pulls.
+  case INPUT_PULLUP:
+    DataBus::Configure(PINMAP_CONFIG_INPUT_PULL);
+    DataBus::Write(0xFF);
+    break;
+
+  case INPUT_PULLDOWN:
+    DataBus::Configure(PINMAP_CONFIG_INPUT_PULL);
+    DataBus::Write(0x00);
+    break;
+
+  default:
+    // Unsupported mode, leave the bus as it is.
+    break;
+  }
 }
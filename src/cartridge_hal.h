@@ -15,6 +15,7 @@ void HAL_Cartridge_SetDataBus(uint8_t data);
 uint8_t HAL_Cartridge_GetDataBus(void);
 void HAL_Cartridge_DataBusInput(void);
 void HAL_Cartridge_DataBusOutput(void);
+uint8_t HAL_Cartridge_ProbeDataBus(uint32_t pull);
 void HAL_Cartridge_EnableRom(void);
 void HAL_Cartridge_DisableRom(void);
 
@@ -3,37 +3,52 @@
   ******************************************************************************
   * @file           : cartridge_wiring.h
   * @brief          : Cartridge wiring definitions
-  * 
+  *
   * Usage:
-  * Define the pin number for each cartridge connection
+  * List the pin of each cartridge connection, in bus bit order.
+  * Wiring consecutive bus bits to consecutive pins of one port gives the
+  * fastest bus access. Invalid or conflicting wiring fails to compile.
   ******************************************************************************
   */
 
 #ifndef CARTRIDGE_WIRING_H
 #define CARTRIDGE_WIRING_H
 
-#define A0_PIN PA15
-#define A1_PIN PB3
-#define A2_PIN PB4
-#define A3_PIN PB5
-#define A4_PIN PB6
-#define A5_PIN PB7
-#define A6_PIN PB8
-#define A7_PIN PB9
-#define A8_PIN PA0
-#define A9_PIN PA1
-#define A10_PIN PA3
-#define A11_PIN PA2
-#define A12_PIN PA4
-#define CS_PIN A12_PIN /* The A12 pin is used as a chipselect line for the cartridge ROM. */
-#define D0_PIN PA8
-#define D1_PIN PA9
-#define D2_PIN PA10
-#define D3_PIN PB11
-#define D4_PIN PB10
-#define D5_PIN PB13
-#define D6_PIN PB14
-#define D7_PIN PB15
+#include <Arduino.h>
+#include "pin_map.h"
+#include "access_led.h"
 
-#endif /* CARTRIDGE_WIRING_H */
+/** Address bus A0..A11 */
+static constexpr PinName kAddressPins[] = {
+  PA_15, PB_3, PB_4, PB_5, PB_6, PB_7, PB_8, PB_9, PA_0, PA_1, PA_3, PA_2
+};
+
+/** Data bus D0..D7 */
+static constexpr PinName kDataPins[] = {
+  PA_8, PA_9, PA_10, PB_11, PB_10, PB_13, PB_14, PB_15
+};
+
+/** The A12 pin is used as a chipselect line for the cartridge ROM. */
+static constexpr PinName kChipSelectPins[] = { PA_4 };
+
+/** Pins used by other functions of the board: USB D-/D+ and the access LED. */
+static constexpr PinName kReservedPins[] = { PA_11, PA_12, ACCESS_LED_PIN };
 
+static_assert(sizeof(kAddressPins) / sizeof(kAddressPins[0]) == 12, "Address bus must have 12 pins");
+static_assert(sizeof(kDataPins) / sizeof(kDataPins[0]) == 8, "Data bus must have 8 pins");
+static_assert(sizeof(kChipSelectPins) / sizeof(kChipSelectPins[0]) == 1, "Chip select must have 1 pin");
+static_assert(PinMap_Valid(kAddressPins) && PinMap_Valid(kDataPins) && PinMap_Valid(kChipSelectPins),
+              "Cartridge pin is not a GPIO pin");
+static_assert(PinMap_Unique(kAddressPins) && PinMap_Unique(kDataPins), "Cartridge pin used twice");
+static_assert(PinMap_Disjoint(kAddressPins, kDataPins)
+              && PinMap_Disjoint(kAddressPins, kChipSelectPins)
+              && PinMap_Disjoint(kDataPins, kChipSelectPins), "Cartridge pin shared between busses");
+static_assert(PinMap_Disjoint(kAddressPins, kReservedPins)
+              && PinMap_Disjoint(kDataPins, kReservedPins)
+              && PinMap_Disjoint(kChipSelectPins, kReservedPins), "Cartridge pin conflicts with board function");
+
+typedef PinMap<sizeof(kAddressPins) / sizeof(kAddressPins[0]), kAddressPins> AddressBus;
+typedef PinMap<sizeof(kDataPins) / sizeof(kDataPins[0]), kDataPins> DataBus;
+typedef PinMap<sizeof(kChipSelectPins) / sizeof(kChipSelectPins[0]), kChipSelectPins> ChipSelect;
+
+#endif /* CARTRIDGE_WIRING_H */
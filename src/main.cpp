@@ -10,6 +10,17 @@
   * -# Receive reply
   * -# (Optional) Unpack device info. See ::InfoTypedef 
   * 
+  * Cartridge events (optional, see ::CAPABILITY_EVENTS):
+  * -# Send ::ENABLE_EVENTS. Events are off again on every new connection.
+  * -# While the host is idle the firmware polls for cartridge insertion/removal.
+  *    On a change it sends an unsolicited ::CARTRIDGE_EVENT frame (payload ::EventTypedef).
+  *    The host must accept such a frame before any reply.
+  * -# On insertion the first bank is preloaded, so a following READ_BLOCK of
+  *    exactly that bank is answered from RAM.
+  * 
+  * Polling drives the address and data bus, so with events enabled the bus
+  * state set by e.g. EMULATE_SINGLE does not persist across idle periods.
+  * 
   * Request/reply structure:
   * offset          | Field name
   * --------------- | ----------------------------
@@ -30,6 +41,12 @@
 // Defines
 //------------------------------------------------------------------------------
 #define BUFFER_SIZE 8192
+#define DEVICE_TYPE 0xEFBE  /**< Device type reported by GET_INFO */
+#define HW_VERSION 0x03     /**< Hardware version reported by GET_INFO */
+#define HW_REVISION 0x00    /**< Hardware revision reported by GET_INFO */
+#define FW_VERSION 0x03     /**< Firmware version reported by GET_INFO */
+#define FW_REVISION 0x01    /**< Firmware revision reported by GET_INFO */
+#define DETECT_SETTLE_TIME 250 /**< Time for cartridge contacts to settle after insertion or removal. \n Unit: ms */
 
 //------------------------------------------------------------------------------
 // Typedefs
@@ -45,6 +62,8 @@ typedef enum{
   GET_READ_DELAY = 'D', /**< Get the delay between reads in ms TODO implement */
   GET_INFO = 'I',       /**< Get firmware/hardware version info */
   SYNC = 'S',           /**< Synchronizes soft and firmware by resetting the interpreter. Synchronization character, not an actual command. */
+  ENABLE_EVENTS = 'N',  /**< Enable (data[0] != 0 or no data) or disable (data[0] == 0) ::CARTRIDGE_EVENT frames */
+  CARTRIDGE_EVENT = 'C', /**< Unsolicited frame sent when a cartridge is inserted or removed. Never a request. */
 }CmdTypedef;
 
 
@@ -68,20 +87,40 @@ typedef struct __attribute__((packed)){ /* Packed so structure is well defined.
 } HeaderTypeDef;
 
 
+typedef enum{
+  CAPABILITY_DETECT  = 1, /**< Cartridge insertion detection */
+  CAPABILITY_PRELOAD = 2, /**< First bank is preloaded on insertion while events are enabled */
+  CAPABILITY_EVENTS  = 4, /**< Supports ::ENABLE_EVENTS and unsolicited ::CARTRIDGE_EVENT frames */
+}CapabilityTypeDef;
+
+
 typedef struct __attribute__((packed)){
-  uint32_t uniqueid;
+  uint32_t uniqueid;      /**< XOR of the three words of uid. Identifies the device. */
   uint16_t devicetype;
   uint8_t hwversion;
   uint8_t hwrevision;
   uint8_t fwversion;
   uint8_t fwrevision;
+  uint32_t uid[3];        /**< Full 96-bit STM32 unique device ID */
+  uint32_t capabilities;  /**< Supported features. See ::CapabilityTypeDef */
 } InfoTypedef;
 
 
+typedef struct __attribute__((packed)){
+  uint8_t inserted;       /**< 1 when a cartridge was inserted, 0 when removed */
+  uint8_t preloaded;      /**< 1 when preloadAddress..preloadAddress+preloadLength is cached */
+  uint16_t preloadAddress;
+  uint16_t preloadLength;
+  uint32_t preloadHash;   /**< FNV-1a hash of the preloaded bank */
+} EventTypedef;
+
+
 //------------------------------------------------------------------------------
 // Private function prototypes
 //------------------------------------------------------------------------------
 static uint16_t CalculateChecksum(uint8_t *buf, uint16_t len);
+static void SendFrame(HeaderTypeDef *header, uint8_t *buf);
+static void PollCartridge(bool *present);
 
 
 //------------------------------------------------------------------------------
@@ -109,6 +148,8 @@ void loop(void)
   uint16_t checksum;
   uint16_t errorFlags;
   size_t len;
+  bool eventsEnabled = false;    // Plain request/reply until the host asks for events.
+  bool cartridgePresent = false; // Report a present cartridge when events get enabled.
 
   Serial.begin();
   // Wait for serial port to be connected.
@@ -127,13 +168,23 @@ void loop(void)
 
     if (!Serial)
     {
-      // Restart interpreter
+      // Restart interpreter. The cartridge may be swapped while nobody polls.
+      Cartridge_InvalidatePreload();
       break;
     }
 
     len = Serial.readBytes((char *)&header, sizeof(header));
-    if (header.cmd == SYNC || len == 0) {
-      // Serial timed out or synchronizing, try again.
+    if (len == 0) {
+      // Serial timed out, host is idle.
+      if (eventsEnabled)
+      {
+        PollCartridge(&cartridgePresent);
+      }
+      continue;
+    }
+
+    if (header.cmd == SYNC) {
+      // Synchronizing, try again.
       continue;
     }
 
@@ -216,16 +267,26 @@ void loop(void)
         errorFlags |= ERROR_COMMAND;
         break;
 
-      case GET_INFO: // TODO move magic numbers into struct
-        info->uniqueid = 0xEFBEADDE;
-        info->devicetype = 0xEFBE;
-        info->hwversion = 0x03;
-        info->hwrevision = 0x00;
-        info->fwversion = 0x03;
-        info->fwrevision = 0x00;
+      case GET_INFO:
+        info->uid[0] = HAL_GetUIDw0();
+        info->uid[1] = HAL_GetUIDw1();
+        info->uid[2] = HAL_GetUIDw2();
+        info->uniqueid = info->uid[0] ^ info->uid[1] ^ info->uid[2];
+        info->devicetype = DEVICE_TYPE;
+        info->hwversion = HW_VERSION;
+        info->hwrevision = HW_REVISION;
+        info->fwversion = FW_VERSION;
+        info->fwrevision = FW_REVISION;
+        info->capabilities = CAPABILITY_DETECT | CAPABILITY_PRELOAD | CAPABILITY_EVENTS;
         header.replyLength = sizeof(InfoTypedef);
         break;
 
+      case ENABLE_EVENTS:
+        eventsEnabled = (header.requestLength == 0) || (data[0] != 0);
+        cartridgePresent = false;
+        header.replyLength = 0;
+        break;
+
       default:
         errorFlags |= ERROR_COMMAND;
         break;
@@ -244,11 +305,7 @@ void loop(void)
       header.replyLength = 0;
     }
 
-    header.checksum = CalculateChecksum((uint8_t *)&header, sizeof(header) - sizeof(header.checksum));
-    header.checksum += CalculateChecksum(data, header.replyLength);
-
-    Serial.write((uint8_t *)&header, sizeof(header));
-    Serial.write(data, header.replyLength);
+    SendFrame(&header, data);
   }
 }
 
@@ -268,3 +325,75 @@ static uint16_t CalculateChecksum(uint8_t *buf, uint16_t len)
 
   return checksum;
 }
+
+
+/**
+ * @brief Checksum and send a reply or event frame.
+ * @param header[in,out] Header. Checksum is filled in.
+ * @param buf[in] Data of header->replyLength bytes
+ */
+static void SendFrame(HeaderTypeDef *header, uint8_t *buf)
+{
+  header->checksum = CalculateChecksum((uint8_t *)header, sizeof(*header) - sizeof(header->checksum));
+  header->checksum += CalculateChecksum(buf, header->replyLength);
+
+  Serial.write((uint8_t *)header, sizeof(*header));
+  Serial.write(buf, header->replyLength);
+}
+
+
+/**
+ * @brief Check for cartridge insertion/removal and notify the host.
+ *
+ * A change must persist for DETECT_SETTLE_TIME before it is reported.
+ * On insertion the first bank is preloaded before the event is sent.
+ * @param present[in,out] Cartridge state last reported to the host
+ */
+static void PollCartridge(bool *present)
+{
+  HeaderTypeDef header;
+  EventTypedef *event = (EventTypedef *)data;
+  uint32_t hash = 0;
+  bool preloaded = false;
+  bool detected = Cartridge_Detect();
+
+  if (detected == *present)
+  {
+    return;
+  }
+
+  // Ignore contact bounce while the cartridge is being pushed in or pulled out.
+  delay(DETECT_SETTLE_TIME);
+  if (Cartridge_Detect() != detected)
+  {
+    return;
+  }
+
+  if (detected)
+  {
+    AccessLed_On();
+    Cartridge_Preload();
+    preloaded = Cartridge_GetPreloadHash(&hash);
+    AccessLed_Off();
+  }
+  else
+  {
+    Cartridge_InvalidatePreload();
+  }
+
+  *present = detected;
+
+  event->inserted = detected;
+  event->preloaded = preloaded;
+  event->preloadAddress = CARTRIDGE_PRELOAD_ADDRESS;
+  event->preloadLength = preloaded ? CARTRIDGE_BANK_SIZE : 0;
+  event->preloadHash = hash;
+
+  header.cmd = CARTRIDGE_EVENT;
+  header.status = 0;
+  header.requestLength = 0;
+  header.replyLength = sizeof(EventTypedef);
+  header.address = CARTRIDGE_PRELOAD_ADDRESS;
+
+  SendFrame(&header, data);
+}
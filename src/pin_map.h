@@ -0,0 +1,261 @@
+/**
+  ******************************************************************************
+  * @file           : pin_map.h
+  * @brief          : Compile-time GPIO pin map for parallel busses
+  *
+  * Usage:
+  * Declare the pins of a bus as a constexpr PinName array in bit order, then
+  * use PinMap<N, pins> to write, read or configure the whole bus.
+  * Bits wired to consecutive pins of one port form a run and are moved with a
+  * single mask and shift. Each port is accessed once per bus operation.
+  * All shifts and masks are resolved at compile time.
+  ******************************************************************************
+  */
+
+#ifndef PIN_MAP_H_
+#define PIN_MAP_H_
+
+#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define PINMAP_PORT_COUNT 5 /**< GPIOA..GPIOE */
+#define PINMAP_INLINE inline __attribute__((always_inline))
+
+#define PINMAP_CONFIG_INPUT      0x4 /**< CNF/MODE nibble: floating input */
+#define PINMAP_CONFIG_INPUT_PULL 0x8 /**< CNF/MODE nibble: input with pull-up/down, selected by the output data bit */
+#define PINMAP_CONFIG_OUTPUT     0x3 /**< CNF/MODE nibble: push-pull output, 50 MHz */
+
+
+//------------------------------------------------------------------------------
+// Compile-time helpers
+//------------------------------------------------------------------------------
+constexpr uint32_t PinMap_Port(PinName pin)
+{
+  return STM_PORT(pin);
+}
+
+constexpr uint32_t PinMap_Bit(PinName pin)
+{
+  return STM_PIN(pin);
+}
+
+/**
+ * @brief Number of pins from index i on that are consecutive bits of one port.
+ */
+template <size_t N>
+constexpr size_t PinMap_RunLength(const PinName (&pins)[N], size_t i)
+{
+  return (i + 1 < N
+          && PinMap_Port(pins[i + 1]) == PinMap_Port(pins[i])
+          && PinMap_Bit(pins[i + 1]) == PinMap_Bit(pins[i]) + 1)
+         ? 1 + PinMap_RunLength(pins, i + 1)
+         : 1;
+}
+
+/**
+ * @brief Number of mask/shift runs needed to move the whole bus.
+ */
+template <size_t N>
+constexpr size_t PinMap_RunCount(const PinName (&pins)[N], size_t i = 0)
+{
+  return i < N ? 1 + PinMap_RunCount(pins, i + PinMap_RunLength(pins, i)) : 0;
+}
+
+/**
+ * @brief Mask of the bus pins on a port.
+ */
+template <size_t N>
+constexpr uint32_t PinMap_PortMask(const PinName (&pins)[N], uint32_t port, size_t i = 0)
+{
+  return i < N
+         ? (PinMap_Port(pins[i]) == port ? 1UL << PinMap_Bit(pins[i]) : 0) | PinMap_PortMask(pins, port, i + 1)
+         : 0;
+}
+
+/**
+ * @brief Mask of the bus pins in a port configuration register.
+ * @param high false for CRL (pins 0..7), true for CRH (pins 8..15)
+ */
+template <size_t N>
+constexpr uint32_t PinMap_ConfigMask(const PinName (&pins)[N], uint32_t port, bool high, size_t i = 0)
+{
+  return i < N
+         ? ((PinMap_Port(pins[i]) == port && (PinMap_Bit(pins[i]) >= 8) == high)
+            ? 0xFUL << ((PinMap_Bit(pins[i]) & 7) * 4) : 0) | PinMap_ConfigMask(pins, port, high, i + 1)
+         : 0;
+}
+
+template <size_t N>
+constexpr bool PinMap_Contains(const PinName (&pins)[N], PinName pin, size_t i = 0)
+{
+  return i < N && (pins[i] == pin || PinMap_Contains(pins, pin, i + 1));
+}
+
+/**
+ * @brief true when every pin exists on a GPIO port.
+ */
+template <size_t N>
+constexpr bool PinMap_Valid(const PinName (&pins)[N], size_t i = 0)
+{
+  return i >= N || (pins[i] != NC && PinMap_Port(pins[i]) < PINMAP_PORT_COUNT && PinMap_Valid(pins, i + 1));
+}
+
+/**
+ * @brief true when no pin is used twice.
+ */
+template <size_t N>
+constexpr bool PinMap_Unique(const PinName (&pins)[N], size_t i = 0)
+{
+  return i >= N || (!PinMap_Contains(pins, pins[i], i + 1) && PinMap_Unique(pins, i + 1));
+}
+
+/**
+ * @brief true when the two pin lists share no pin.
+ */
+template <size_t N, size_t M>
+constexpr bool PinMap_Disjoint(const PinName (&a)[N], const PinName (&b)[M], size_t i = 0)
+{
+  return i >= N || (!PinMap_Contains(b, a[i]) && PinMap_Disjoint(a, b, i + 1));
+}
+
+
+//------------------------------------------------------------------------------
+// Bus access
+//------------------------------------------------------------------------------
+template <size_t I> struct PinMap_Index {};
+
+template <size_t N, const PinName (&Pins)[N]>
+class PinMap
+{
+public:
+  static const size_t kRuns = PinMap_RunCount(Pins); /**< Mask/shift operations per bus access */
+
+  /**
+   * @brief Drive the bus pins to value. One BSRR write per port.
+   */
+  static PINMAP_INLINE void Write(uint32_t value)
+  {
+    WritePort(value, PinMap_Index<0>());
+  }
+
+  /**
+   * @brief Sample the bus pins. One IDR read per port.
+   */
+  static PINMAP_INLINE uint32_t Read(void)
+  {
+    uint32_t idr[PINMAP_PORT_COUNT];
+
+    ReadPort(idr, PinMap_Index<0>());
+    return Gather(idr, PinMap_Index<0>());
+  }
+
+  /**
+   * @brief Set the mode of all bus pins. Leaves the output data bits untouched.
+   *
+   * The output data bits select pull-up or pull-down for PINMAP_CONFIG_INPUT_PULL,
+   * set them with Write().
+   * @param config CNF/MODE nibble, e.g. PINMAP_CONFIG_OUTPUT
+   */
+  static PINMAP_INLINE void Configure(uint32_t config)
+  {
+    ConfigurePort(config * 0x11111111UL, PinMap_Index<0>());
+  }
+
+private:
+  static PINMAP_INLINE GPIO_TypeDef *Gpio(uint32_t port)
+  {
+    return (GPIO_TypeDef *)(GPIOA_BASE + port * (GPIOB_BASE - GPIOA_BASE));
+  }
+
+  /* Move the run starting at bus bit I to/from its port bit. */
+  template <size_t I>
+  static PINMAP_INLINE uint32_t BusToPort(uint32_t value)
+  {
+    const uint32_t mask = ((1UL << PinMap_RunLength(Pins, I)) - 1) << I;
+    const uint32_t bit = PinMap_Bit(Pins[I]);
+    return bit >= I ? (value & mask) << (bit - I) : (value & mask) >> (I - bit);
+  }
+
+  template <size_t I>
+  static PINMAP_INLINE uint32_t PortToBus(uint32_t value)
+  {
+    const uint32_t bit = PinMap_Bit(Pins[I]);
+    const uint32_t mask = ((1UL << PinMap_RunLength(Pins, I)) - 1) << bit;
+    return I >= bit ? (value & mask) << (I - bit) : (value & mask) >> (bit - I);
+  }
+
+  /* Bits of value that belong to port P, one run at a time. */
+  template <uint32_t P>
+  static PINMAP_INLINE uint32_t Scatter(uint32_t, PinMap_Index<N>)
+  {
+    return 0;
+  }
+
+  template <uint32_t P, size_t I>
+  static PINMAP_INLINE uint32_t Scatter(uint32_t value, PinMap_Index<I>)
+  {
+    return (PinMap_Port(Pins[I]) == P ? BusToPort<I>(value) : 0)
+           | Scatter<P>(value, PinMap_Index<I + PinMap_RunLength(Pins, I)>());
+  }
+
+  static PINMAP_INLINE uint32_t Gather(const uint32_t *, PinMap_Index<N>)
+  {
+    return 0;
+  }
+
+  template <size_t I>
+  static PINMAP_INLINE uint32_t Gather(const uint32_t *idr, PinMap_Index<I>)
+  {
+    return PortToBus<I>(idr[PinMap_Port(Pins[I])])
+           | Gather(idr, PinMap_Index<I + PinMap_RunLength(Pins, I)>());
+  }
+
+  static PINMAP_INLINE void WritePort(uint32_t, PinMap_Index<PINMAP_PORT_COUNT>) {}
+
+  template <size_t P>
+  static PINMAP_INLINE void WritePort(uint32_t value, PinMap_Index<P>)
+  {
+    const uint32_t mask = PinMap_PortMask(Pins, P);
+
+    if (mask)
+    {
+      uint32_t set = Scatter<P>(value, PinMap_Index<0>());
+      Gpio(P)->BSRR = ((mask & ~set) << 16) | set;
+    }
+    WritePort(value, PinMap_Index<P + 1>());
+  }
+
+  static PINMAP_INLINE void ReadPort(uint32_t *, PinMap_Index<PINMAP_PORT_COUNT>) {}
+
+  template <size_t P>
+  static PINMAP_INLINE void ReadPort(uint32_t *idr, PinMap_Index<P>)
+  {
+    if (PinMap_PortMask(Pins, P))
+    {
+      idr[P] = Gpio(P)->IDR;
+    }
+    ReadPort(idr, PinMap_Index<P + 1>());
+  }
+
+  static PINMAP_INLINE void ConfigurePort(uint32_t, PinMap_Index<PINMAP_PORT_COUNT>) {}
+
+  template <size_t P>
+  static PINMAP_INLINE void ConfigurePort(uint32_t config, PinMap_Index<P>)
+  {
+    const uint32_t low = PinMap_ConfigMask(Pins, P, false);
+    const uint32_t high = PinMap_ConfigMask(Pins, P, true);
+
+    if (low)
+    {
+      Gpio(P)->CRL = (Gpio(P)->CRL & ~low) | (config & low);
+    }
+    if (high)
+    {
+      Gpio(P)->CRH = (Gpio(P)->CRH & ~high) | (config & high);
+    }
+    ConfigurePort(config, PinMap_Index<P + 1>());
+  }
+};
+
+#endif /* PIN_MAP_H_ */